@@ -16,6 +16,10 @@ function useDeviceSockets({ devices, points }) {
   const [deviceStatusById, setDeviceStatusById] = React.useState({});
   const [dataByDevice, setDataByDevice] = React.useState({});
   const wsMapRef = React.useRef({});
+  // Device replies stream as {"id","part"} slices and end with {"id","done"}
+  // (or {"id","cancelled"}): slices are collected per device + RPC id and only
+  // replace the series once the reply is complete.
+  const partialRef = React.useRef({}); // deviceId → rpcId → { sensor: items[] }
 
   const WS_HOST = import.meta?.env?.VITE_WS_HOST || "ws://192.168.10.101:3000";
   const urlFor = React.useCallback(
@@ -75,6 +79,7 @@ function useDeviceSockets({ devices, points }) {
     };
 
     sock.onclose = () => {
+      delete partialRef.current[id];
       setUiStatus(id, "Disconnected");
       setDevStatus(id, "unknown");
     };
@@ -89,16 +94,30 @@ function useDeviceSockets({ devices, points }) {
       }
       if (typeof msg?.data === "string") {
         const buckets = {};
+        let ctrl = null;
         for (const raw of msg.data.split("\n")) {
           const line = raw.trim(); if (!line) continue;
           const d = ndjsonLineToObj(line); if (!d) continue;
+          if (d.id && !d.sensor) { ctrl = d; continue; }
           const item = { ts: d.ts, sensor: d.sensor, value: d.value };
           const key = String(item.sensor || "");
           if (!key) continue;
           (buckets[key] ||= []).push(item);
         }
+        if (ctrl) {
+          const parts = (partialRef.current[id] ||= {});
+          if (ctrl.done || ctrl.cancelled) {
+            const acc = parts[ctrl.id];
+            delete parts[ctrl.id];
+            if (ctrl.done) replaceDeviceSensors(id, acc || {});
+            return;
+          }
+          const acc = (parts[ctrl.id] ||= {});
+          for (const [key, arr] of Object.entries(buckets)) (acc[key] ||= []).push(...arr);
+          return;
+        }
         if (Object.keys(buckets).length) {
-          replaceDeviceSensors(id, buckets);
+          replaceDeviceSensors(id, buckets); // untagged reply (older firmware)
         }
         return;
       }
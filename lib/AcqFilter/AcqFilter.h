@@ -0,0 +1,157 @@
+/******************************************************
+ * AcqFilter — oversampled probe filtering, free of Arduino/ESP-IDF
+ *
+ * median-of-5 (spike rejection) → one-pole IIR → 1:ACQ_DECIM decimation,
+ * all fixed-point milli-units (26.512 °C → 26512), plus the CSV trace
+ * parser/replayer. Only the C standard library is used so the same code
+ * runs on the device and in the [env:native] unit tests.
+ ******************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+enum { ACQ_TEMP=0, ACQ_PH, ACQ_SAL, ACQ_SENSORS };
+
+static const uint16_t ACQ_DECIM        = 25;   // 50 Hz in → one output per 500 ms
+static const uint8_t  ACQ_MEDIAN_N     = 5;
+static const uint8_t  ACQ_RAW_LEN      = 8;    // power of two ≥ ACQ_MEDIAN_N
+static const uint8_t  ACQ_IIR_SHIFT    = 3;    // alpha = 1/8
+static const uint8_t  ACQ_IIR_FRAC     = 8;    // extra fraction bits kept in IIR state
+
+// Compare-exchange written as min/max so the compiler can use Xtensa MIN/MAX
+// (GCC -O2 usually does; it is not guaranteed to be branch-free)
+static inline void acqSort2(int32_t& a, int32_t& b) {
+  int32_t lo = a<b ? a : b, hi = a<b ? b : a; a = lo; b = hi;
+}
+// Median of 5 with a 7-exchange network; scalar, run once per sensor
+static inline int32_t acqMedian5(int32_t a, int32_t b, int32_t c, int32_t d, int32_t e) {
+  acqSort2(a,b); acqSort2(d,e); acqSort2(a,d); acqSort2(b,e);
+  acqSort2(b,c); acqSort2(c,d); acqSort2(b,c);
+  return c;
+}
+
+// Per-sensor raw rings + filter state. push() takes one raw sample per sensor
+// and returns true every ACQ_DECIM calls with the filtered values in out.
+struct AcqFilter {
+  int32_t  raw[ACQ_SENSORS][ACQ_RAW_LEN];
+  uint8_t  head;
+  uint8_t  count;
+  int32_t  iir[ACQ_SENSORS];      // Q(ACQ_IIR_FRAC) milli-units
+  uint16_t decim;
+
+  void reset() { head = 0; count = 0; decim = 0; }
+
+  bool push(const int32_t in[ACQ_SENSORS], int32_t out[ACQ_SENSORS]) {
+    head = (head + 1) & (ACQ_RAW_LEN - 1);
+    for (uint8_t s=0;s<ACQ_SENSORS;++s) raw[s][head] = in[s];
+    if (count < ACQ_RAW_LEN) ++count;
+
+    for (uint8_t s=0;s<ACQ_SENSORS;++s) {
+      int32_t med = in[s];
+      if (count >= ACQ_MEDIAN_N) {
+        const int32_t* r = raw[s];
+        const uint8_t m = ACQ_RAW_LEN - 1;
+        med = acqMedian5(r[head], r[(head-1)&m], r[(head-2)&m], r[(head-3)&m], r[(head-4)&m]);
+      }
+      const int32_t x = med * (1 << ACQ_IIR_FRAC);
+      if (count == 1) iir[s] = x;                       // prime on first sample
+      else iir[s] += (x - iir[s]) >> ACQ_IIR_SHIFT;
+    }
+
+    if (++decim < ACQ_DECIM) return false;
+    decim = 0;
+    for (uint8_t s=0;s<ACQ_SENSORS;++s)
+      out[s] = (iir[s] + (1 << (ACQ_IIR_FRAC-1))) >> ACQ_IIR_FRAC;
+    return true;
+  }
+};
+
+// Parse "temperature,ph,salinity" or "ts,temperature,ph,salinity" into
+// milli-units. Returns false for headers, comments and short rows.
+static inline bool acqParseCsvRow(const char* line, int32_t out[ACQ_SENSORS], bool& hasTs, double& ts) {
+  double col[ACQ_SENSORS+1]; uint8_t n=0;
+  const char* p = line;
+  while (n < ACQ_SENSORS+1) {
+    char* end; double v = strtod(p, &end);
+    if (end == p) break;
+    col[n++] = v;
+    p = end; while (*p==' ') ++p;
+    if (*p != ',') break;
+    ++p;
+  }
+  if (n < ACQ_SENSORS) return false;
+  hasTs = (n > ACQ_SENSORS);
+  ts    = hasTs ? col[0] : 0;
+  const double* v = &col[n-ACQ_SENSORS];
+  for (uint8_t i=0;i<ACQ_SENSORS;++i) out[i] = (int32_t)lround(v[i]*1000.0);
+  return true;
+}
+
+// Replays a recorded trace, looping at EOF.
+// Rows with a ts column (milliseconds, any origin) are paced by it: each row is
+// held until tMs has advanced by its offset from the first row, so a 10 Hz or
+// irregular trace plays at its recorded speed; the last row is held for the
+// gap before it, then the trace loops. Rows without ts are played one
+// per sample() call, i.e. the trace must then be recorded at 50 Hz. The first
+// data row decides which mode a trace uses.
+// Reader: bool readLine(char* buf, size_t cap) (false at EOF), void rewind().
+template<class Reader>
+struct AcqCsvReplay {
+  struct Row { int32_t v[ACQ_SENSORS]; double ts; bool wrap; };
+
+  Reader&  in;
+  Row      cur, next;
+  bool     primed   = false;
+  bool     haveNext = false;
+  bool     timed    = false;
+  double   firstTs  = 0;      // ts of the first row of the current pass
+  uint32_t startMs  = 0;      // tMs at which that pass started
+  double   gap      = 0;      // ts step into cur (hold time of the last row)
+
+  explicit AcqCsvReplay(Reader& r) : in(r) {}
+
+  bool sample(uint32_t tMs, int32_t out[ACQ_SENSORS]) {
+    if (!primed) {
+      if (!fetch(cur)) return false;
+      primed = true;
+      startMs = tMs; firstTs = cur.ts;
+      haveNext = fetch(next);
+    } else {
+      while (haveNext) {
+        const double elapsed = (double)(uint32_t)(tMs - startMs);
+        if (timed) {
+          const double due = next.wrap ? cur.ts - firstTs + gap : next.ts - firstTs;
+          if (elapsed < due) break;
+          if (!next.wrap) gap = (next.ts > cur.ts) ? next.ts - cur.ts : 0;
+        }
+        cur = next;
+        haveNext = fetch(next);
+        if (cur.wrap) { startMs = tMs; firstTs = cur.ts; }
+        if (!timed || cur.wrap) break;
+      }
+    }
+    for (uint8_t i=0;i<ACQ_SENSORS;++i) out[i] = cur.v[i];
+    return true;
+  }
+
+private:
+  // Next data row; rewinds once at EOF and marks the row as the start of a pass
+  bool fetch(Row& r) {
+    char line[96];
+    r.wrap = false;
+    for (uint8_t tries=0; tries<2; ++tries) {
+      while (in.readLine(line, sizeof(line))) {
+        bool hasTs;
+        if (!acqParseCsvRow(line, r.v, hasTs, r.ts)) continue;
+        if (!primed && !haveNext && !r.wrap) timed = hasTs;   // first data row
+        if (timed && !hasTs) continue;                        // mixed trace: skip
+        return true;
+      }
+      in.rewind(); // loop the trace
+      r.wrap = true;
+    }
+    return false;
+  }
+};
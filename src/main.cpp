@@ -4,6 +4,7 @@
  * GATT split into two primary services:
  *   Service A (A100): status, name, token, reboot
  *   Service B (A200): Wi-Fi SSID/PASS, WS host/port
+ *   Service C (A300): telemetry stream (works without Wi-Fi/backend)
  *
  * Extras:
  *  - Token characteristic is READ|WRITE and included in status JSON
@@ -11,21 +12,37 @@
  *  - Chunked TOKEN write assembly (stores full JWT instead of last chunk only)
  *  - Token sanitization, WS reconnect on token change
  *  - Backoff + logging for auth errors; show last WS error in status JSON
+ *  - Ordered WS endpoint list (primary + fallbacks) with health scoring,
+ *    automatic failover and fail-back to the best endpoint
+ *  - Oversampled acquisition (50 Hz) with fixed-point median + IIR filtering,
+ *    decimated into a 500 ms history that get_last_n/get_latest report
+ *  - Service C (A300): binary telemetry notifications packed to each central's
+ *    MTU, credit-paced, with history backfill; several centrals at once
+ *  - RPC replies run as queued, time-sliced jobs (2 ms budget per loop,
+ *    socket back-pressure, "cancel" method)
  ******************************************************/
 
 // =================== 1) INCLUDES & CONSTANTS ===================
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WebSocketsClient.h>
+#include <WiFiClientSecure.h>
+#include <lwip/sockets.h>
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include <ctype.h>
+#include <AcqFilter.h>
+#ifdef ACQ_REPLAY_CSV
+#include <LittleFS.h>
+#endif
 
 // BLE (ESP32 BLE Arduino / nkolban)
 #include <BLEDevice.h>
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include <esp_gatts_api.h>
+#include <esp_gap_ble_api.h>
 
 // ---- Initial defaults (overridden by NVS if present)
 static const char* DEF_WIFI_SSID  = "None";
@@ -53,12 +70,20 @@ static const char* CH_SSID_UUID     = "0000a201-0000-1000-8000-00805f9b34fb"; //
 static const char* CH_PASS_UUID     = "0000a202-0000-1000-8000-00805f9b34fb"; // write
 static const char* CH_WSHOST_UUID   = "0000a203-0000-1000-8000-00805f9b34fb"; // read/write
 static const char* CH_WSPORT_UUID   = "0000a204-0000-1000-8000-00805f9b34fb"; // read/write
+static const char* CH_WSFB_UUID     = "0000a205-0000-1000-8000-00805f9b34fb"; // read/write ("host:port,host:port")
+static const char* CH_WSHEALTH_UUID = "0000a206-0000-1000-8000-00805f9b34fb"; // read JSON (endpoint health)
+
+// Service C: telemetry
+static const char* SVC_C_UUID       = "0000a300-0000-1000-8000-00805f9b34fb";
+//   A3xx chars
+static const char* CH_TELEM_UUID    = "0000a301-0000-1000-8000-00805f9b34fb"; // notify (binary frames)
 
 // =================== 2) PERSISTENT CONFIG (Preferences) ===================
 Preferences prefs;
 String   cfg_ssid, cfg_pass, cfg_name, cfg_token;
 String   cfg_ws_host = DEF_WS_HOST;
 uint16_t cfg_ws_port = DEF_WS_PORT;
+String   cfg_ws_fallbacks;           // comma-separated "host[:port]" list, tried after the primary
 
 // -------- Token / URL helpers --------
 
@@ -128,13 +153,6 @@ static bool isHostValidBare(const String& h) {
   return true;
 }
 
-static bool isHostValid(const String& h) {
-  String copy = h;
-  bool tlsHint=false;
-  stripScheme(copy, tlsHint);  // normalize
-  return isHostValidBare(copy);
-}
-
 static bool shouldUseTLS(const String& rawHost, uint16_t port) {
   String h = rawHost;
   bool tlsHint=false;
@@ -153,6 +171,7 @@ static void loadConfig() {
   cfg_token   = sanitizeToken(prefs.getString("token",  DEF_HOME_TOKEN)); // sanitize on load
   cfg_ws_host = prefs.getString("wshost", DEF_WS_HOST);
   cfg_ws_port = prefs.getUShort("wsport", DEF_WS_PORT);
+  cfg_ws_fallbacks = prefs.getString("wsfb", "");
   prefs.end();
 }
 
@@ -200,21 +219,234 @@ static void saveUShort(const char* key, uint16_t v) {
 }
 
 // =================== 3) WS TELEMETRY / RPC (ON-DEMAND) ===================
-WebSocketsClient ws;
+// WebSocketsClient plus a non-blocking "is there room to send?" check
+class WsClient : public WebSocketsClient {
+  // WiFiClientSecure keeps its socket in a protected sslclient context
+  struct SecureFd : WiFiClientSecure {
+    static int of(WiFiClientSecure* c) {
+      sslclient_context* ctx = c->*(&SecureFd::sslclient);
+      return ctx ? ctx->socket : -1;
+    }
+  };
+public:
+  // lwIP reports a TCP socket writable only while more than TCP_SNDLOWAT
+  // (about half the send buffer) is free, so a slice then goes out without
+  // blocking in WiFiClient::write
+  bool canWrite() {
+    if (!_client.tcp) return false;
+    const int fd = (_client.isSSL && _client.ssl) ? SecureFd::of(_client.ssl) : _client.tcp->fd();
+    if (fd < 0) return false;
+    fd_set wr; FD_ZERO(&wr); FD_SET(fd, &wr);
+    timeval tv = { 0, 0 };
+    return select(fd + 1, nullptr, &wr, nullptr, &tv) > 0;
+  }
+};
+WsClient ws;
 static bool wsBegun = false;         // we started ws.begin/SSL() at least once
 volatile bool flagWsReconf = false;  // reconfigure WS after BLE write
 
-// WS auth/error tracking & backoff
-static bool     wsAuthBlocked = false;
-static uint32_t wsAuthRetryAt = 0;
+// WS error tracking
 static String   wsLastReason  = "";
 
-// Backoff helper
+// --- Endpoint list + health scoring
+// Endpoint 0 is the primary (wshost/wsport), then the "wsfb" fallbacks in order.
+// Lower score = better: list rank + connect time + ping RTT + recent failures.
+static const uint8_t  WS_MAX_ENDPOINTS      = 4;
+static const uint32_t WS_CONNECT_TIMEOUT_MS = 8000;    // begin → CONNECTED, else fail over
+static const uint32_t WS_RETRY_BASE_MS      = 3000;    // per-endpoint backoff, doubles per failure
+static const uint32_t WS_RETRY_MAX_MS       = 60000;
+static const uint32_t WS_FAIL_MEMORY_MS     = 120000;  // failures weigh on the score this long (x fails)
+static const uint32_t WS_FAIL_MEMORY_MAX_MS = 900000;
+static const uint32_t WS_FAIL_PENALTY_MS    = 2000;
+static const uint32_t WS_RANK_PENALTY_MS    = 250;     // prefer list order when stats are close
+static const uint32_t WS_PRIOR_CONNECT_MS   = 1500;    // assumed until measured
+static const uint32_t WS_PRIOR_RTT_MS       = 250;
+static const uint32_t WS_RTT_PROBE_MS       = 10000;   // RTT ping period while connected
+static const uint32_t WS_FAILBACK_DWELL_MS  = 60000;   // stay at least this long before switching
+static const uint32_t WS_FAILBACK_MARGIN_MS = 150;     // hysteresis for fail-back
+
+struct WsEndpoint {
+  String   host;          // bare host (no scheme/port)
+  uint16_t port;
+  bool     tls;           // wss:// hint or 443/8443, fixed at parse time
+  IPAddress ip;           // last resolved address (0.0.0.0 = never resolved)
+  uint32_t connectMs;     // EWMA begin → CONNECTED (0 = not measured)
+  uint32_t rttMs;         // EWMA ping → pong (0 = not measured)
+  uint8_t  fails;         // consecutive failures (reset on CONNECTED)
+  uint32_t lastFailAt;
+  uint32_t retryAt;       // not eligible before this (millis)
+};
+
+static WsEndpoint wsEps[WS_MAX_ENDPOINTS];
+static uint8_t    wsEpCount     = 0;
+static int8_t     wsEpCur       = -1;     // endpoint of the current ws.begin
+static bool       wsConnected   = false;
+static uint32_t   wsBeginAt     = 0;
+static uint32_t   wsConnectedAt = 0;
+static uint32_t   wsRttSentAt   = 0;      // 0 = no probe in flight
+static uint32_t   wsRttLastAt   = 0;
+static bool       wsDropPending = false;  // set from WS callback, applied in wsTick
+static uint8_t    WS_RTT_TAG[]  = { 'r','t','t' }; // ping payload, tells our probes from heartbeats
+
+static uint32_t ewma(uint32_t avg, uint32_t sample) {
+  return avg ? (avg*3 + sample)/4 : sample;
+}
+
+// Parse "host", "host:port" or "ws(s)://host:port/path" into bare host + port + tls
+static bool parseEndpoint(const String& raw, uint16_t defPort, String& host, uint16_t& port, bool& tls) {
+  String rest = raw; rest.trim();
+  int sch = rest.indexOf("://");
+  if (sch >= 0) rest = rest.substring(sch+3);
+  int slash = rest.indexOf('/');
+  if (slash > 0) rest = rest.substring(0, slash);
+  int colon = rest.indexOf(':');
+  long p = (colon > 0) ? rest.substring(colon+1).toInt() : 0;
+
+  bool tlsHint=false;
+  host = raw;
+  stripScheme(host, tlsHint);
+  if (!isHostValidBare(host)) return false;
+  port = (p >= 1 && p <= 65535) ? (uint16_t)p : (tlsHint ? 443 : defPort);
+  tls  = shouldUseTLS(raw, port);
+  return true;
+}
+
+static void addWsEndpoint(const String& host, uint16_t port, bool tls) {
+  if (wsEpCount >= WS_MAX_ENDPOINTS) {
+    Serial.printf("⚠️  WS endpoint list full, dropping %s:%u\n", host.c_str(), port);
+    return;
+  }
+  for (uint8_t i=0;i<wsEpCount;++i)
+    if (wsEps[i].port == port && wsEps[i].host.equalsIgnoreCase(host)) return; // duplicate
+  WsEndpoint& e = wsEps[wsEpCount++];
+  e.host = host; e.port = port; e.tls = tls;
+  e.ip = IPAddress();
+  e.connectMs = 0; e.rttMs = 0; e.fails = 0; e.lastFailAt = 0; e.retryAt = 0;
+}
+
+// Rebuild from cfg_* (resets health stats); call from loop only
+static void rebuildWsEndpoints() {
+  wsEpCount = 0;
+  wsEpCur   = -1;
+  String host; uint16_t port; bool tls;
+  if (parseEndpoint(cfg_ws_host, cfg_ws_port, host, port, tls))
+    addWsEndpoint(host, cfg_ws_port, shouldUseTLS(cfg_ws_host, cfg_ws_port));
+
+  int from = 0;
+  while (from <= (int)cfg_ws_fallbacks.length()) {
+    int comma = cfg_ws_fallbacks.indexOf(',', from);
+    if (comma < 0) comma = cfg_ws_fallbacks.length();
+    String item = cfg_ws_fallbacks.substring(from, comma); item.trim();
+    from = comma + 1;
+    if (!item.length()) continue;
+    if (parseEndpoint(item, DEF_WS_PORT, host, port, tls)) addWsEndpoint(host, port, tls);
+    else Serial.printf("⚠️  Ignoring invalid WS fallback '%s'\n", item.c_str());
+  }
+}
+
+static uint32_t wsEndpointScore(uint8_t i, uint32_t now) {
+  const WsEndpoint& e = wsEps[i];
+  uint32_t score = i * WS_RANK_PENALTY_MS;
+  score += (e.connectMs ? e.connectMs : WS_PRIOR_CONNECT_MS) / 4;
+  score += e.rttMs ? e.rttMs : WS_PRIOR_RTT_MS;
+  if (e.fails) {
+    uint32_t memory = WS_FAIL_MEMORY_MS * e.fails;
+    if (memory > WS_FAIL_MEMORY_MAX_MS) memory = WS_FAIL_MEMORY_MAX_MS;
+    if (now - e.lastFailAt < memory) score += e.fails * WS_FAIL_PENALTY_MS;
+  }
+  return score;
+}
+
+// Best endpoint that is not backing off, or -1
+static int8_t wsPickEndpoint(uint32_t now) {
+  int8_t best = -1; uint32_t bestScore = UINT32_MAX;
+  for (uint8_t i=0;i<wsEpCount;++i) {
+    if ((int32_t)(now - wsEps[i].retryAt) < 0) continue;
+    uint32_t sc = wsEndpointScore(i, now);
+    if (sc < bestScore) { bestScore = sc; best = (int8_t)i; }
+  }
+  return best;
+}
+
+// Penalize endpoint i; backoffMs=0 → exponential default
+static void wsPenalize(uint8_t i, const char* why, uint32_t backoffMs = 0) {
+  WsEndpoint& e = wsEps[i];
+  if (e.fails < 255) e.fails++;
+  e.lastFailAt = millis();
+  if (!backoffMs) {
+    backoffMs = WS_RETRY_BASE_MS << (e.fails > 5 ? 5 : e.fails-1);
+    if (backoffMs > WS_RETRY_MAX_MS) backoffMs = WS_RETRY_MAX_MS;
+  }
+  e.retryAt = e.lastFailAt + backoffMs;
+  Serial.printf("⚠️  WS endpoint %s:%u failed (%s), fails=%u, retry in %u ms\n",
+                e.host.c_str(), e.port, why, e.fails, (unsigned)backoffMs);
+}
+
+static void wsEndpointFailed(const char* why, uint32_t backoffMs = 0) {
+  if (wsEpCur < 0 || wsEpCur >= wsEpCount) return;
+  wsPenalize(wsEpCur, why, backoffMs);
+}
+
+// --- Fail-back probe
+// Before leaving a working link, check the candidate answers a TCP connect.
+// The connect is non-blocking and polled from wsHealthTick; it uses the address
+// cached by connectWebSocket, so the probe itself never waits on DNS.
+static const uint32_t WS_PROBE_TIMEOUT_MS = 3000;
+static int      wsProbeFd = -1;
+static int8_t   wsProbeEp = -1;
+static uint32_t wsProbeAt = 0;
+
+static void wsProbeClose() {
+  if (wsProbeFd >= 0) close(wsProbeFd);
+  wsProbeFd = -1;
+  wsProbeEp = -1;
+}
+
+static bool wsProbeStart(int8_t i) {
+  const uint32_t ip = (uint32_t)wsEps[i].ip;
+  if (!ip) return false; // never resolved: stay put until a real connect tries it
+  const int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) return false;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  sockaddr_in sa = {};
+  sa.sin_family      = AF_INET;
+  sa.sin_port        = htons(wsEps[i].port);
+  sa.sin_addr.s_addr = ip;
+  if (connect(fd, (sockaddr*)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) {
+    close(fd);
+    wsPenalize(i, "probe: connect");
+    return false;
+  }
+  wsProbeFd = fd;
+  wsProbeEp = i;
+  wsProbeAt = millis();
+  return true;
+}
+
+// 1 = reachable, -1 = failed, 0 = pending
+static int wsProbePoll() {
+  fd_set wr; FD_ZERO(&wr); FD_SET(wsProbeFd, &wr);
+  timeval tv = { 0, 0 };
+  if (select(wsProbeFd + 1, nullptr, &wr, nullptr, &tv) > 0) {
+    int err = 0; socklen_t len = sizeof(err);
+    getsockopt(wsProbeFd, SOL_SOCKET, SO_ERROR, &err, &len);
+    return err ? -1 : 1;
+  }
+  return (millis() - wsProbeAt > WS_PROBE_TIMEOUT_MS) ? -1 : 0;
+}
+
+// Tear down the current connection without penalizing its endpoint
+static void wsDrop() {
+  wsProbeClose();
+  wsConnected = false;
+  if (wsBegun) { wsBegun = false; ws.disconnect(); }
+}
+
+// Backoff helper: park the current endpoint; the next best one is tried meanwhile
 static void blockReconnect(const String& reason, uint32_t ms = 30000) {
-  wsAuthBlocked = true;
-  wsAuthRetryAt = millis() + ms;
   wsLastReason  = reason;
   Serial.printf("⛔ WS auth blocked for %u ms: %s\n", (unsigned)ms, reason.c_str());
+  wsEndpointFailed(reason.c_str(), ms);
 }
 
 // --- NDJSON helpers
@@ -271,6 +503,250 @@ static void readSensorsAt(uint32_t tMs, float& temp, float& ph, float& sal) {
   sal  = clampf(baseS+sS+tinyJitter(0.05f),28,36);
 }
 
+// --- Acquisition: oversample → median-of-N → IIR → decimate
+// Probes are sampled every ACQ_SAMPLE_MS and fed through AcqFilter
+// (lib/AcqFilter: median-of-5, one-pole IIR, 1:ACQ_DECIM); each decimated
+// output lands in the history ring that the RPCs read. Values are fixed-point
+// milli-units (26.512 °C → 26512).
+static const char* const ACQ_NAMES[ACQ_SENSORS] = { "temperature", "ph", "salinity" };
+
+static const uint32_t ACQ_SAMPLE_MS    = 20;   // 50 Hz oversampling (× ACQ_DECIM = 500 ms)
+static const uint8_t  ACQ_MAX_CATCHUP  = 10;   // samples per tick before resyncing
+static const uint16_t ACQ_HISTORY_LEN  = 200;  // matches get_last_n max
+
+// Pluggable probe source: one raw reading per sensor (milli-units) for time tMs
+struct AcqSource {
+  virtual bool sample(uint32_t tMs, int32_t out[ACQ_SENSORS]) = 0;
+  virtual ~AcqSource() {}
+};
+
+// Synthetic generator (default)
+struct SyntheticSource : AcqSource {
+  bool sample(uint32_t tMs, int32_t out[ACQ_SENSORS]) override {
+    float t,p,s; readSensorsAt(tMs,t,p,s);
+    out[ACQ_TEMP] = lroundf(t*1000.0f);
+    out[ACQ_PH]   = lroundf(p*1000.0f);
+    out[ACQ_SAL]  = lroundf(s*1000.0f);
+    return true;
+  }
+};
+
+#ifdef ACQ_REPLAY_CSV
+// Replays a recorded trace from LittleFS; rows with a ts column (ms) are paced
+// by it, plain rows play at 50 Hz (see AcqCsvReplay)
+struct LittleFsLineReader {
+  File f;
+  bool readLine(char* buf, size_t cap) {
+    if (!f.available()) return false;
+    size_t n = f.readBytesUntil('\n', buf, cap-1); buf[n] = 0;
+    return true;
+  }
+  void rewind() { f.seek(0); }
+};
+
+struct CsvReplaySource : AcqSource {
+  LittleFsLineReader               reader;
+  AcqCsvReplay<LittleFsLineReader> replay{reader};
+  bool begin(const char* path) {
+    if (!LittleFS.begin(false)) { Serial.println("⚠️  LittleFS mount failed"); return false; }
+    reader.f = LittleFS.open(path, "r");
+    if (!reader.f) { Serial.printf("⚠️  Replay trace %s not found\n", path); return false; }
+    Serial.printf("📼 Replaying %s (%u bytes)\n", path, (unsigned)reader.f.size());
+    return true;
+  }
+  bool sample(uint32_t tMs, int32_t out[ACQ_SENSORS]) override {
+    return replay.sample(tMs, out);
+  }
+};
+static CsvReplaySource acqCsvSource;
+#endif
+
+static SyntheticSource acqSynthSource;
+static AcqSource*      acqSource = &acqSynthSource;
+
+static AcqFilter acqFilter;
+static uint32_t  acqNextAt = 0;
+
+// Decimated history (what the RPCs report)
+struct AcqSample { uint32_t ts; int32_t v[ACQ_SENSORS]; };
+static AcqSample acqHist[ACQ_HISTORY_LEN];
+static uint16_t  acqHistHead  = 0;   // next write slot
+static uint16_t  acqHistCount = 0;
+static uint32_t  acqHistSeq   = 0;   // total samples ever pushed (seq of the next one)
+
+static void acqPushSample(uint32_t tMs, const int32_t raw[ACQ_SENSORS]) {
+  int32_t v[ACQ_SENSORS];
+  if (!acqFilter.push(raw, v)) return;
+  AcqSample& h = acqHist[acqHistHead];
+  h.ts = tMs;
+  for (uint8_t s=0;s<ACQ_SENSORS;++s) h.v[s] = v[s];
+  acqHistHead = (acqHistHead + 1) % ACQ_HISTORY_LEN;
+  if (acqHistCount < ACQ_HISTORY_LEN) ++acqHistCount;
+  ++acqHistSeq;
+}
+
+// Sample by absolute sequence number (must be within the last acqHistCount)
+static const AcqSample& acqHistBySeq(uint32_t seq) {
+  return acqHist[seq % ACQ_HISTORY_LEN];
+}
+
+static void acqBegin() {
+#ifdef ACQ_REPLAY_CSV
+  if (acqCsvSource.begin(ACQ_REPLAY_CSV)) acqSource = &acqCsvSource;
+#endif
+  acqNextAt = millis();
+}
+
+// Take every due sample slot (bounded catch-up, then resync)
+static void acqTick() {
+  const uint32_t now = millis();
+  uint8_t taken = 0;
+  while ((int32_t)(now - acqNextAt) >= 0) {
+    if (taken++ == ACQ_MAX_CATCHUP) { acqNextAt = now + ACQ_SAMPLE_MS; break; }
+    int32_t raw[ACQ_SENSORS];
+    if (acqSource->sample(acqNextAt, raw)) acqPushSample(acqNextAt, raw);
+    acqNextAt += ACQ_SAMPLE_MS;
+  }
+}
+
+// --- Cooperative RPC jobs
+// History replies run as resumable jobs: each rpcTick() formats lines for at
+// most RPC_BUDGET_US and sends at most one frame, and only when the socket
+// has room (ws.canWrite()), so heartbeats, BLE and Wi-Fi never wait on a large
+// get_last_n. Jobs run FIFO and never interleave. A reply is:
+//   {"id":..,"result":"ok"}                       ack (routed to the requester)
+//   {"id":..,"part":k}\n + NDJSON sample lines    k = 0,1,… one frame per slice
+//   {"id":..,"done":true,"samples":N}             end marker
+// or {"id":..,"cancelled":true} if cancelled mid-stream, or if the rest of
+// the requested window left the history ring before it could be sent.
+static const uint8_t  RPC_MAX_JOBS     = 4;
+static const uint32_t RPC_BUDGET_US    = 2000;
+static const size_t   RPC_SLICE_BYTES  = 1400;  // ~one TCP segment; below TCP_SNDLOWAT
+
+struct RpcJob {
+  String   id;
+  uint32_t seq;       // next history seq to emit
+  uint32_t end;       // one past the last seq
+  bool     started;   // "ok" already sent
+  uint16_t part;      // next slice number
+  uint16_t samples;   // samples emitted so far
+  String   slice;
+};
+static RpcJob   rpcJobs[RPC_MAX_JOBS];
+static uint8_t  rpcJobHead  = 0;
+static uint8_t  rpcJobCount = 0;
+
+static RpcJob& rpcJobAt(uint8_t i) { return rpcJobs[(rpcJobHead + i) % RPC_MAX_JOBS]; }
+
+// Queue the newest n history samples for id
+static bool rpcEnqueue(const char* id, uint16_t n) {
+  if (rpcJobCount >= RPC_MAX_JOBS) return false;
+  RpcJob& j = rpcJobAt(rpcJobCount++);
+  j.id      = id;
+  j.end     = acqHistSeq;
+  j.seq     = acqHistSeq - n;
+  j.started = false;
+  j.part    = 0;
+  j.samples = 0;
+  j.slice   = "";
+  j.slice.reserve(RPC_SLICE_BYTES + 3*64);
+  return true;
+}
+
+static void rpcRemove(uint8_t i) {
+  for (; i+1 < rpcJobCount; ++i) std::swap(rpcJobAt(i), rpcJobAt(i+1));
+  rpcJobAt(i).slice = "";
+  --rpcJobCount;
+}
+
+// {"id":..,"part":k} — first line of every slice
+static void rpcPartHeader(String& out, const RpcJob& j) {
+  DynamicJsonDocument doc(160);
+  doc["id"]   = j.id;
+  doc["part"] = j.part;
+  serializeJson(doc, out);
+  out += '\n';
+}
+
+// {"id":..,"done":true,"samples":N} or {"id":..,"cancelled":true}
+static String rpcEndMarker(const RpcJob& j, bool cancelled) {
+  DynamicJsonDocument doc(160);
+  doc["id"] = j.id;
+  if (cancelled) doc["cancelled"] = true;
+  else { doc["done"] = true; doc["samples"] = j.samples; }
+  String out; serializeJson(doc, out);
+  return out;
+}
+
+// Cancel by RPC id; a queued job gets an error reply, a streaming one an end marker
+static bool rpcCancel(const char* id) {
+  for (uint8_t i=0;i<rpcJobCount;++i) {
+    RpcJob& j = rpcJobAt(i);
+    if (j.id != id) continue;
+    if (!j.started) sendRpcReplyErr(id, "cancelled");
+    else { String end = rpcEndMarker(j, true); ws.sendTXT(end); }
+    Serial.printf("🛑 RPC job %s cancelled (%s)\n", id, j.started ? "streaming" : "queued");
+    rpcRemove(i);
+    return true;
+  }
+  return false;
+}
+
+// Run the head job for one time slice; at most one (non-blocking) send
+static void rpcTick() {
+  if (!rpcJobCount) return;
+  if (!wsConnected) {
+    Serial.printf("🛑 Dropping %u RPC job(s): WS down\n", rpcJobCount);
+    while (rpcJobCount) rpcRemove(0);
+    return;
+  }
+
+  RpcJob& j = rpcJobAt(0);
+  const uint32_t oldest = acqHistSeq - acqHistCount;
+  const bool pending = (int32_t)(j.end - j.seq) > 0;
+  if (pending && (int32_t)(j.end - oldest) <= 0) {
+    // The rest of the window was overwritten while the job waited (slow link)
+    if (!ws.canWrite()) return;
+    if (!j.started) sendRpcReplyErr(j.id.c_str(), "expired");
+    else { String end = rpcEndMarker(j, true); ws.sendTXT(end); }
+    Serial.printf("⌛ RPC %s expired (%u samples sent)\n", j.id.c_str(), j.samples);
+    rpcRemove(0);
+    return;
+  }
+  if ((int32_t)(j.seq - oldest) < 0) j.seq = oldest; // partly overwritten while queued
+
+  // Format until the slice is full, the job ends or the budget is spent
+  const uint32_t t0 = micros();
+  if (pending && !j.slice.length()) rpcPartHeader(j.slice, j);
+  while ((int32_t)(j.end - j.seq) > 0 && j.slice.length() < RPC_SLICE_BYTES && micros() - t0 < RPC_BUDGET_US) {
+    const AcqSample& h = acqHistBySeq(j.seq++);
+    for (uint8_t s=0;s<ACQ_SENSORS;++s) sendNdjsonLine(j.slice,ACQ_NAMES[s],h.ts,h.v[s]/1000.0f);
+    ++j.samples;
+  }
+
+  const bool done = (int32_t)(j.end - j.seq) <= 0;
+  const bool sliceReady = j.slice.length() >= RPC_SLICE_BYTES || (done && j.slice.length());
+  if (!j.started || sliceReady) {
+    if (!ws.canWrite()) return; // socket back-pressure; keep the slice for a later pass
+    if (!j.started) {
+      sendRpcReplyOk(j.id.c_str());
+      j.started = true;
+      return;
+    }
+    ws.sendTXT(j.slice);
+    j.slice = "";
+    ++j.part;
+    return;
+  }
+
+  if (done && ws.canWrite()) {
+    String end = rpcEndMarker(j, false);
+    ws.sendTXT(end);
+    Serial.printf("📤 RPC %s done (%u samples, %u parts)\n", j.id.c_str(), j.samples, j.part);
+    rpcRemove(0);
+  }
+}
+
 // --- RPC handler (only on-demand methods)
 static void handleRpc(const JsonDocument& doc) {
   const char* id = doc["id"] | "";
@@ -278,29 +754,25 @@ static void handleRpc(const JsonDocument& doc) {
   if (!id[0] || !method[0]) return;
 
   if (strcmp(method,"get_last_n")==0) {
+    if (!acqHistCount) { sendRpcReplyErr(id,"no_data"); return; }
     int n = doc["params"]["n"] | 10; n = constrain(n,1,200);
-    String batch; batch.reserve(n*3*64);
-    uint32_t base=millis(); const uint32_t step=500;
-    for (int i=n-1;i>=0;--i) {
-      uint32_t ts=base-(uint32_t)i*step;
-      float t,p,s; readSensorsAt(ts,t,p,s);
-      sendNdjsonLine(batch,"temperature",ts,t);
-      sendNdjsonLine(batch,"ph",ts,p);
-      sendNdjsonLine(batch,"salinity",ts,s);
-    }
-    sendRpcReplyOk(id);
-    ws.sendTXT(batch);
-    Serial.printf("📤 Sent last %d samples (%d lines)\n", n, n*3);
+    if (n > acqHistCount) n = acqHistCount;
+    if (!rpcEnqueue(id, n)) { sendRpcReplyErr(id,"busy"); return; }
+    Serial.printf("📥 Queued last %d samples (%d lines), jobs=%u\n", n, n*3, rpcJobCount);
     return;
   }
 
   if (strcmp(method,"get_latest")==0) {
-    sendRpcReplyOk(id);
-    uint32_t ts=millis(); float t,p,s; readSensorsAt(ts,t,p,s);
-    String batch; sendNdjsonLine(batch,"temperature",ts,t);
-    sendNdjsonLine(batch,"ph",ts,p); sendNdjsonLine(batch,"salinity",ts,s);
-    ws.sendTXT(batch);
-    Serial.println("📤 Sent latest sample (3 lines)");
+    if (!acqHistCount) { sendRpcReplyErr(id,"no_data"); return; }
+    // Queued too, so it never lands in the middle of another reply's slices
+    if (!rpcEnqueue(id, 1)) { sendRpcReplyErr(id,"busy"); return; }
+    return;
+  }
+
+  if (strcmp(method,"cancel")==0) {
+    const char* target = doc["params"]["id"] | "";
+    if (rpcCancel(target)) sendRpcReplyOk(id);
+    else sendRpcReplyErr(id,"not_found");
     return;
   }
 
@@ -312,10 +784,26 @@ static void onWsEvent(WStype_t type, uint8_t* payload, size_t len) {
     case WStype_CONNECTED:
       Serial.println("🔗 WebSocket connected");
       wsLastReason = ""; // clear last error on success
+      wsConnected   = true;
+      wsConnectedAt = millis();
+      wsRttSentAt   = 0;
+      wsRttLastAt   = wsConnectedAt;
+      if (wsEpCur >= 0) {
+        WsEndpoint& e = wsEps[wsEpCur];
+        e.connectMs = ewma(e.connectMs, wsConnectedAt - wsBeginAt);
+        e.fails = 0;
+      }
       break;
 
     case WStype_DISCONNECTED:
       Serial.println("❌ WebSocket disconnected");
+      // Unplanned drop (wsDrop() clears wsBegun first): fail over instead of
+      // letting the library retry the same endpoint
+      if (wsBegun) {
+        wsEndpointFailed(wsConnected ? "connection lost" : "connect failed");
+        wsConnected   = false;
+        wsDropPending = true;
+      }
       break;
 
     case WStype_TEXT: {
@@ -336,8 +824,8 @@ static void onWsEvent(WStype_t type, uint8_t* payload, size_t len) {
         if (authErr) {
           String why = reason[0] ? String(reason) : (error[0] ? String(error) : String("unauthorized"));
           Serial.printf("⛔ WS auth error: %s\n", why.c_str());
-          blockReconnect(why, 30000); // 30s backoff
-          if (wsBegun) { ws.disconnect(); wsBegun = false; }
+          blockReconnect(why, 30000); // 30s backoff for this endpoint
+          wsDrop();
           break;
         }
 
@@ -353,7 +841,14 @@ static void onWsEvent(WStype_t type, uint8_t* payload, size_t len) {
     }
 
     case WStype_PING: Serial.println("📡 Got PING from server"); break;
-    case WStype_PONG: Serial.println("📡 Got PONG from server"); break;
+    case WStype_PONG:
+      Serial.println("📡 Got PONG from server");
+      if (wsRttSentAt && wsEpCur >= 0 && len == sizeof(WS_RTT_TAG) && memcmp(payload, WS_RTT_TAG, len) == 0) {
+        WsEndpoint& e = wsEps[wsEpCur];
+        e.rttMs = ewma(e.rttMs, millis() - wsRttSentAt);
+        wsRttSentAt = 0;
+      }
+      break;
     default: break;
   }
 }
@@ -362,7 +857,9 @@ static void onWsEvent(WStype_t type, uint8_t* payload, size_t len) {
 BLEServer*        bleServer = nullptr;
 BLECharacteristic
   *chStatus=nullptr,*chSsid=nullptr,*chPass=nullptr,*chName=nullptr,
-  *chToken=nullptr,*chCmd=nullptr,*chWsHost=nullptr,*chWsPort=nullptr;
+  *chToken=nullptr,*chCmd=nullptr,*chWsHost=nullptr,*chWsPort=nullptr,
+  *chWsFb=nullptr,*chWsHealth=nullptr,*chTelem=nullptr;
+BLE2902*          telemCccd = nullptr;
 
 bool bleClientConnected=false;
 uint32_t lastStatusNotifyMs=0;
@@ -378,6 +875,152 @@ static const size_t TOKEN_CHUNK_MAX = 180; // must match admin chunk size
 
 static String currentMac() { return WiFi.macAddress(); }
 
+// --- telemetry stream (Service C)
+// Frame (little-endian): [ver=1][count][seq u32][baseTs u32]
+//   + count × [dt u16][temperature i16][ph i16][salinity i16]   (centi-units)
+// seq is the history sequence of the first record, so a central can spot
+// gaps/duplicates; dt is ms since baseTs.
+static const uint8_t  BLE_MAX_CENTRALS      = 3;
+static const uint8_t  BLE_TELEM_VER         = 1;
+static const uint8_t  BLE_TELEM_HDR         = 10;
+static const uint8_t  BLE_TELEM_REC         = 8;
+static const uint8_t  BLE_TELEM_MAX_CREDITS = 4;     // notifications per connection-interval burst
+static const uint32_t BLE_TELEM_FLUSH_MS    = 2000;  // send a partial frame once its oldest sample is this old
+static const uint16_t BLE_TELEM_BUF         = 512;   // ≥ max ATT payload (MTU 517 - 3)
+
+// Slot fields down to intervalMs are written only from the BT task (the
+// slot is published by setting `active` last); credits/creditAt/cursor belong
+// to loop(), which resets them when it sees pendingSubscribe.
+struct BleCentral {
+  volatile bool active;
+  volatile bool subscribed;       // this connection wrote 0x0001 to the telemetry CCCD
+  volatile bool pendingSubscribe; // new subscription; loop() sets cursor + credits
+  volatile bool congested;        // from ESP_GATTS_CONGEST_EVT
+  uint16_t connId;
+  uint8_t  bda[6];                // peer address (GAP events are keyed by it)
+  volatile uint16_t intervalMs;   // connection interval → one credit per interval
+  uint8_t  credits;
+  uint32_t creditAt;
+  uint32_t cursor;                // next history seq to send
+};
+static BleCentral bleCentrals[BLE_MAX_CENTRALS];
+static volatile esp_gatt_if_t bleGattsIf = ESP_GATT_IF_NONE;
+
+// Raw GATTS hook: interface for per-connection notifies, per-connection
+// telemetry subscription (the library keeps one CCCD value for everyone)
+// and congestion state
+static void bleGattsEvent(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t* param) {
+  if (event == ESP_GATTS_CONNECT_EVT) {
+    bleGattsIf = gatts_if;
+  } else if (event == ESP_GATTS_WRITE_EVT) {
+    if (!telemCccd || param->write.handle != telemCccd->getHandle() || param->write.len != 2) return;
+    const bool on = param->write.value[0] & 0x01;
+    for (auto& c : bleCentrals) {
+      if (!c.active || c.connId != param->write.conn_id) continue;
+      if (on && !c.subscribed) { c.pendingSubscribe = true; __sync_synchronize(); }
+      c.subscribed = on;
+      Serial.printf("📈 Telemetry %s (conn=%u)\n", on ? "subscribed" : "unsubscribed", c.connId);
+    }
+  } else if (event == ESP_GATTS_CONGEST_EVT) {
+    for (auto& c : bleCentrals)
+      if (c.active && c.connId == param->congest.conn_id) c.congested = param->congest.congested;
+  }
+}
+
+// Raw GAP hook: centrals usually renegotiate the connection interval right
+// after connecting; keep the credit period in step
+static void bleGapEvent(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+  if (event != ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT || param->update_conn_params.status != ESP_BT_STATUS_SUCCESS) return;
+  uint16_t itv = (uint16_t)(param->update_conn_params.conn_int * 5 / 4); // 1.25 ms units
+  if (itv < 8) itv = 8;
+  for (auto& c : bleCentrals) {
+    if (!c.active || memcmp(c.bda, param->update_conn_params.bda, sizeof(c.bda)) != 0) continue;
+    c.intervalMs = itv;
+    Serial.printf("📈 Conn interval (conn=%u) → %u ms\n", c.connId, itv);
+  }
+}
+
+static uint8_t bleCentralCount() {
+  uint8_t n=0; for (auto& c : bleCentrals) if (c.active) ++n;
+  return n;
+}
+
+static inline void putLe16(uint8_t* p, uint16_t v) { p[0]=v; p[1]=v>>8; }
+static inline void putLe32(uint8_t* p, uint32_t v) { p[0]=v; p[1]=v>>8; p[2]=v>>16; p[3]=v>>24; }
+static inline int16_t milliToCenti(int32_t v) {
+  v = (v >= 0 ? v+5 : v-5) / 10;
+  return (int16_t)constrain(v, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+}
+
+// Pack up to maxCount samples starting at seq; returns records written
+static uint8_t bleTelemBuild(uint8_t* buf, uint32_t seq, uint8_t maxCount, size_t& len) {
+  const uint32_t baseTs = acqHistBySeq(seq).ts;
+  uint8_t n = 0;
+  uint8_t* p = buf + BLE_TELEM_HDR;
+  while (n < maxCount) {
+    const AcqSample& h = acqHistBySeq(seq + n);
+    if (h.ts - baseTs > 0xFFFF) break; // dt no longer fits; next frame
+    putLe16(p, (uint16_t)(h.ts - baseTs));
+    for (uint8_t s=0;s<ACQ_SENSORS;++s) putLe16(p + 2 + 2*s, (uint16_t)milliToCenti(h.v[s]));
+    p += BLE_TELEM_REC; ++n;
+  }
+  buf[0] = BLE_TELEM_VER;
+  buf[1] = n;
+  putLe32(buf+2, seq);
+  putLe32(buf+6, baseTs);
+  len = p - buf;
+  return n;
+}
+
+// Stream history + live samples to each central, full frames first, paced by credits
+static void bleTelemetryTick() {
+  if (!chTelem || bleGattsIf == ESP_GATT_IF_NONE) return;
+  static uint8_t frame[BLE_TELEM_BUF];
+  const uint32_t now = millis();
+  const uint32_t oldest = acqHistSeq - acqHistCount;
+
+  for (auto& c : bleCentrals) {
+    if (!c.active || !c.subscribed) continue;
+    if (c.pendingSubscribe) {
+      c.pendingSubscribe = false;
+      c.cursor   = oldest;                 // backfill the whole history
+      c.credits  = BLE_TELEM_MAX_CREDITS;
+      c.creditAt = now;
+    }
+    if (c.congested) continue;
+
+    const uint16_t itv = c.intervalMs;
+    const uint32_t refill = (now - c.creditAt) / itv;
+    if (refill) {
+      c.creditAt += refill * itv;
+      c.credits = (c.credits + refill >= BLE_TELEM_MAX_CREDITS) ? BLE_TELEM_MAX_CREDITS : c.credits + refill;
+    }
+    if ((int32_t)(c.cursor - oldest) < 0) c.cursor = oldest; // fell behind the ring
+
+    uint16_t mtu = bleServer->getPeerMTU(c.connId);
+    if (mtu < 23) mtu = 23;
+    size_t room = mtu - 3;
+    if (room > BLE_TELEM_BUF) room = BLE_TELEM_BUF;
+    const uint8_t maxRec = (room - BLE_TELEM_HDR) / BLE_TELEM_REC;
+
+    while (c.credits) {
+      const uint32_t pending = acqHistSeq - c.cursor;
+      if (!pending) break;
+      const uint8_t want = pending > maxRec ? maxRec : (uint8_t)pending;
+      // Hold partial frames until they are full or getting stale
+      if (want < maxRec && now - acqHistBySeq(c.cursor).ts < BLE_TELEM_FLUSH_MS) break;
+
+      size_t len = 0;
+      const uint8_t n = bleTelemBuild(frame, c.cursor, want, len);
+      esp_err_t err = esp_ble_gatts_send_indicate(bleGattsIf, c.connId,
+                                                  chTelem->getHandle(), len, frame, false);
+      if (err != ESP_OK) { c.credits = 0; break; } // stack busy; retry next interval
+      c.cursor += n;
+      --c.credits;
+    }
+  }
+}
+
 static String buildStatusJson() {
   // include token; allow for long JWTs; include last WS error
   DynamicJsonDocument doc(1024);
@@ -398,13 +1041,54 @@ static String buildStatusJson() {
   String out; serializeJson(doc,out); return out;
 }
 
+// Endpoint health, kept off the status JSON so that stays under the ATT limit.
+// {"active":i,"eps":[[host,port,score,connect_ms,rtt_ms,fails],...]}; lower score = preferred
+static String buildWsHealthJson() {
+  DynamicJsonDocument doc(512);
+  doc["active"] = wsConnected ? wsEpCur : -1;
+  const uint32_t now = millis();
+  JsonArray eps = doc["eps"].to<JsonArray>();
+  for (uint8_t i=0;i<wsEpCount;++i) {
+    JsonArray e = eps.add<JsonArray>();
+    e.add(wsEps[i].host);
+    e.add(wsEps[i].port);
+    e.add(wsEndpointScore(i, now));
+    e.add(wsEps[i].connectMs);
+    e.add(wsEps[i].rttMs);
+    e.add(wsEps[i].fails);
+  }
+  String out; serializeJson(doc,out); return out;
+}
+
 class ServerCallbacks : public BLEServerCallbacks {
-  void onConnect(BLEServer* s) override {
+  void onConnect(BLEServer* s, esp_ble_gatts_cb_param_t* param) override {
+    const uint16_t connId = param->connect.conn_id;
+    uint16_t itv = (uint16_t)(param->connect.conn_params.interval * 5 / 4); // 1.25 ms units
+    if (itv < 8) itv = 8;
+
+    for (auto& c : bleCentrals) {
+      if (c.active) continue;
+      c.connId           = connId;
+      memcpy(c.bda, param->connect.remote_bda, sizeof(c.bda));
+      c.subscribed       = false;   // cursor is set when it subscribes
+      c.pendingSubscribe = false;
+      c.congested        = false;
+      c.intervalMs       = itv;
+      __sync_synchronize();         // slot contents visible before loop() sees active
+      c.active           = true;
+      break;
+    }
     bleClientConnected=true;
-    Serial.println("🟢 BLE central connected");
+    const uint8_t n = bleCentralCount();
+    Serial.printf("🟢 BLE central connected (conn=%u interval=%u ms, %u/%u)\n",
+                  connId, itv, n, BLE_MAX_CENTRALS);
+    // Keep advertising so more centrals can join
+    if (n < BLE_MAX_CENTRALS) s->getAdvertising()->start();
   }
-  void onDisconnect(BLEServer* s) override {
-    bleClientConnected=false;
+  void onDisconnect(BLEServer* s, esp_ble_gatts_cb_param_t* param) override {
+    for (auto& c : bleCentrals)
+      if (c.active && c.connId == param->disconnect.conn_id) c.active = false;
+    bleClientConnected = bleCentralCount() > 0;
     Serial.println("🔴 BLE central disconnected — restarting advertise");
     s->getAdvertising()->start();
   }
@@ -453,11 +1137,10 @@ public:
         if (chToken) chToken->setValue(cfg_token.c_str());  // keep TOKEN char in sync
         logTokenBrief("📝 TOKEN assembled & saved", cfg_token);
 
-        // new token -> clear previous auth error/backoff and reconfig WS
-        wsAuthBlocked = false;
+        // new token -> clear previous auth error; reconfig WS also resets endpoint backoff
         wsLastReason  = "";
         flagWsReconf = true;
-        if (wsBegun) { ws.disconnect(); wsBegun=false; }
+        wsDrop();
 
         tokenBuf = ""; // reset buffer
       } else {
@@ -483,7 +1166,7 @@ public:
         Serial.printf("📝 WS HOST set: %s%s\n", cfg_ws_host.c_str(), tlsHint ? " (tls-hint)" : "");
       }
       flagWsReconf = true;
-      if (wsBegun) { ws.disconnect(); wsBegun=false; }
+      wsDrop();
 
     } else if (ch==chWsPort) {
       uint32_t p = (uint32_t) s.toInt();
@@ -495,7 +1178,15 @@ public:
       saveUShort("wsport", cfg_ws_port);
       Serial.printf("📝 WS PORT set: %u\n", cfg_ws_port);
       flagWsReconf = true;
-      if (wsBegun) { ws.disconnect(); wsBegun=false; }
+      wsDrop();
+
+    } else if (ch==chWsFb) {
+      // Validated per entry when the endpoint list is rebuilt in wsTick
+      cfg_ws_fallbacks = s;
+      saveString("wsfb", cfg_ws_fallbacks);
+      Serial.printf("📝 WS FALLBACKS set: %s\n", cfg_ws_fallbacks.c_str());
+      flagWsReconf = true;
+      wsDrop();
     }
 
     // Push status update after any write
@@ -507,8 +1198,17 @@ public:
   }
 };
 
+// Health is computed on demand; nothing to keep in sync
+class WsHealthCallbacks : public BLECharacteristicCallbacks {
+  void onRead(BLECharacteristic* ch) override {
+    ch->setValue(buildWsHealthJson().c_str());
+  }
+};
+
 static void setupBLE() {
   String devName = "ESP32-" + currentMac(); devName.replace(":","");
+  BLEDevice::setCustomGattsHandler(bleGattsEvent);
+  BLEDevice::setCustomGapHandler(bleGapEvent);
   BLEDevice::init(devName.c_str());
 
   // (Optional, but helps Web Bluetooth with bigger writes)
@@ -556,6 +1256,22 @@ static void setupBLE() {
     chWsPort->setValue(portStr);
   }
 
+  chWsFb = svcB->createCharacteristic(
+    CH_WSFB_UUID,
+    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
+  );
+  chWsFb->setValue(cfg_ws_fallbacks.c_str());
+
+  chWsHealth = svcB->createCharacteristic(CH_WSHEALTH_UUID, BLECharacteristic::PROPERTY_READ);
+  chWsHealth->setCallbacks(new WsHealthCallbacks());
+
+  // -------- Service C: telemetry --------
+  BLEService* svcC = bleServer->createService(SVC_C_UUID);
+
+  chTelem = svcC->createCharacteristic(CH_TELEM_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+  telemCccd = new BLE2902();
+  chTelem->addDescriptor(telemCccd);
+
   // One callbacks instance for all writable chars
   auto cb = new WriteCallbacks();
   chSsid->setCallbacks(cb);
@@ -565,10 +1281,12 @@ static void setupBLE() {
   chCmd->setCallbacks(cb);
   chWsHost->setCallbacks(cb);
   chWsPort->setCallbacks(cb);
+  chWsFb->setCallbacks(cb);
 
   // Start services
   svcA->start();
   svcB->start();
+  svcC->start();
 
   // Advertise both services
   BLEAdvertising* adv = BLEDevice::getAdvertising();
@@ -577,14 +1295,12 @@ static void setupBLE() {
   adv->setScanResponse(true);
   BLEDevice::startAdvertising();
 
-  Serial.printf("📡 BLE advertising as %s (A100 + A200)\n", devName.c_str());
+  Serial.printf("📡 BLE advertising as %s (A100 + A200, A300 telemetry)\n", devName.c_str());
 }
 
 // =================== 5) WIFI & WS CONNECTION HELPERS ===================
 static bool canStartWs() {
-  return (WiFi.status()==WL_CONNECTED)
-      && isHostValid(cfg_ws_host)
-      && cfg_ws_port>=1 && cfg_ws_port<=65535;
+  return (WiFi.status()==WL_CONNECTED) && wsEpCount>0;
 }
 
 static void connectWiFiNonBlockingStart() {
@@ -614,58 +1330,121 @@ static void connectWebSocket() {
     return;
   }
 
+  const uint32_t now = millis();
+  const int8_t idx = wsPickEndpoint(now);
+  if (idx < 0) return; // every endpoint is backing off
+
   // Optional: log that we’ll still connect with a suspicious token so the server can reply with a reason
   if (!isTokenValid(cfg_token)) {
     Serial.printf("⚠️  Token looks invalid (len=%u) — connecting anyway to get server reason\n",
                   (unsigned)cfg_token.length());
   }
 
-  String host = cfg_ws_host;
-  bool ignoredTlsHint=false;
-  stripScheme(host, ignoredTlsHint);
+  WsEndpoint& ep = wsEps[idx];
+  // The WS client resolves the host again right away (from lwIP's cache), so
+  // this costs no extra wait; it keeps an address for fail-back probes
+  WiFi.hostByName(ep.host.c_str(), ep.ip);
 
   String mac = WiFi.macAddress();
-  seedFromMac(mac);
-
   String path = "/device?token=" + urlEncode(cfg_token) + "&mac=" + urlEncode(mac);
 
-  const bool useTLS = shouldUseTLS(cfg_ws_host, cfg_ws_port);
-  if (useTLS) {
-    ws.beginSSL(host.c_str(), cfg_ws_port, path.c_str());
-    Serial.printf("🔌 WSS begin → wss://%s:%u%s\n", host.c_str(), cfg_ws_port, path.c_str());
+  if (ep.tls) {
+    ws.beginSSL(ep.host.c_str(), ep.port, path.c_str());
+    Serial.printf("🔌 WSS begin [%d] → wss://%s:%u%s\n", idx, ep.host.c_str(), ep.port, path.c_str());
   } else {
-    ws.begin(host.c_str(), cfg_ws_port, path.c_str());
-    Serial.printf("🔌 WS begin → ws://%s:%u%s\n", host.c_str(), cfg_ws_port, path.c_str());
+    ws.begin(ep.host.c_str(), ep.port, path.c_str());
+    Serial.printf("🔌 WS begin [%d] → ws://%s:%u%s\n", idx, ep.host.c_str(), ep.port, path.c_str());
   }
 
   ws.onEvent(onWsEvent);
   ws.enableHeartbeat(15000, 3000, 2);
   ws.setReconnectInterval(3000);
+  wsEpCur     = idx;
+  wsBeginAt   = now;
+  wsConnected = false;
+  wsRttSentAt = 0;
   wsBegun = true;
 }
 
-static void wsTick() {
-  // Respect temporary auth backoff
-  if (wsAuthBlocked) {
-    if ((int32_t)(millis() - wsAuthRetryAt) < 0) {
-      // still blocked; don't start WS yet
-      return;
+// Connect timeout, RTT probes and fail-back while a WS is up
+static void wsHealthTick() {
+  const uint32_t now = millis();
+  WsEndpoint& e = wsEps[wsEpCur];
+
+  if (!wsConnected) {
+    if (now - wsBeginAt > WS_CONNECT_TIMEOUT_MS) {
+      wsEndpointFailed("connect timeout");
+      wsDrop();
     }
-    // backoff elapsed; try again
-    wsAuthBlocked = false;
+    return;
   }
 
-  if (wsBegun) ws.loop();
+  // A probe that never came back counts as a slow sample
+  if (wsRttSentAt && now - wsRttSentAt > WS_RTT_PROBE_MS) {
+    e.rttMs = ewma(e.rttMs, WS_RTT_PROBE_MS);
+    wsRttSentAt = 0;
+  }
+  if (!wsRttSentAt && now - wsRttLastAt >= WS_RTT_PROBE_MS) {
+    wsRttLastAt = now;
+    if (ws.sendPing(WS_RTT_TAG, sizeof(WS_RTT_TAG))) wsRttSentAt = now;
+  }
+
+  // Fail-back probe in flight: switch only once the candidate answered
+  if (wsProbeEp >= 0) {
+    const int r = wsProbePoll();
+    if (!r) return;
+    const int8_t cand = wsProbeEp;
+    const uint32_t took = now - wsProbeAt;
+    wsProbeClose();
+    if (r < 0) { wsPenalize(cand, "fail-back probe"); return; }
+    wsEps[cand].fails = 0; // reachable again
+    if (rpcJobCount) return;
+    Serial.printf("↩️  WS fail-back %s:%u → %s:%u (probe %u ms)\n",
+                  e.host.c_str(), e.port, wsEps[cand].host.c_str(), wsEps[cand].port, (unsigned)took);
+    wsDrop(); // connectWebSocket() picks the best endpoint
+    return;
+  }
+
+  // Fail-back: once settled, probe a clearly better endpoint (e.g. recovered primary)
+  static uint32_t lastFailbackCheck = 0;
+  if (now - wsConnectedAt < WS_FAILBACK_DWELL_MS) return;
+  if (rpcJobCount) return; // don't cut a reply mid-stream
+  if (now - lastFailbackCheck < WS_RTT_PROBE_MS) return;
+  lastFailbackCheck = now;
+
+  const int8_t best = wsPickEndpoint(now);
+  if (best < 0 || best == wsEpCur) return;
+  const uint32_t bestScore = wsEndpointScore(best, now);
+  const uint32_t curScore  = wsEndpointScore(wsEpCur, now);
+  if (bestScore + WS_FAILBACK_MARGIN_MS >= curScore) return;
+
+  if (wsProbeStart(best))
+    Serial.printf("🔎 WS probing %s:%u (score %u) before leaving %s:%u (score %u)\n",
+                  wsEps[best].host.c_str(), wsEps[best].port, (unsigned)bestScore,
+                  e.host.c_str(), e.port, (unsigned)curScore);
+}
 
+static void wsTick() {
   // Apply WS reconfiguration immediately when requested
   if (flagWsReconf) {
     flagWsReconf = false;
-    Serial.printf("🔧 WS reconfig → %s:%u\n", cfg_ws_host.c_str(), cfg_ws_port);
-    if (wsBegun) ws.disconnect();
-    wsBegun = false;
+    rebuildWsEndpoints();
+    Serial.printf("🔧 WS reconfig → %s:%u (+%d fallback)\n",
+                  cfg_ws_host.c_str(), cfg_ws_port, wsEpCount ? wsEpCount-1 : 0);
+    wsDrop();
+  }
+
+  if (wsBegun) ws.loop();
+
+  // Failure seen inside the WS callback → switch endpoint
+  if (wsDropPending) {
+    wsDropPending = false;
+    wsDrop();
   }
 
-  // Start WS once Wi-Fi is connected (and config is valid)
+  if (wsBegun) wsHealthTick();
+
+  // Start WS once Wi-Fi is connected (and an endpoint is eligible)
   if (!wsBegun && canStartWs()) {
     connectWebSocket();
   }
@@ -682,7 +1461,7 @@ static void onWiFiEvent(WiFiEvent_t event) {
       break;
     case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
       Serial.println("📴 WiFi disconnected");
-      if (wsBegun) { ws.disconnect(); wsBegun=false; }
+      wsDrop();
       break;
     default:
       break;
@@ -699,16 +1478,21 @@ void setup() {
   // resetPrefsIfNewSketchOnce();
 
   loadConfig();
-  Serial.printf("CFG name=%s ws=%s:%u\n", cfg_name.c_str(), cfg_ws_host.c_str(), cfg_ws_port);
+  rebuildWsEndpoints();
+  Serial.printf("CFG name=%s ws=%s:%u endpoints=%u\n", cfg_name.c_str(), cfg_ws_host.c_str(), cfg_ws_port, wsEpCount);
 
   WiFi.onEvent(onWiFiEvent);
   connectWiFiNonBlockingStart();
+  seedFromMac(currentMac());  // per-device synthetic offsets, fixed for the whole run
+  acqBegin();
   setupBLE();
 }
 
 void loop() {
+  acqTick();
   wifiTick();
   wsTick();
+  rpcTick();
 
   // Periodic BLE status notify
   if (bleClientConnected && millis()-lastStatusNotifyMs > 2000) {
@@ -718,6 +1502,9 @@ void loop() {
     chStatus->notify();
   }
 
+  // BLE telemetry stream (independent of Wi-Fi/WS)
+  bleTelemetryTick();
+
   // Reboot if asked
   if (flagReboot) {
     flagReboot=false;
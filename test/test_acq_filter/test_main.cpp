@@ -0,0 +1,178 @@
+// Host-side checks for lib/AcqFilter: pio test -e native
+#include <unity.h>
+#include <string.h>
+#include <AcqFilter.h>
+
+// In-memory line reader over an embedded CSV trace
+struct StrReader {
+  const char* text;
+  const char* p;
+  explicit StrReader(const char* t) : text(t), p(t) {}
+  bool readLine(char* buf, size_t cap) {
+    if (!*p) return false;
+    size_t n = 0;
+    while (*p && *p != '\n') { if (n < cap-1) buf[n++] = *p; ++p; }
+    if (*p == '\n') ++p;
+    buf[n] = 0;
+    return true;
+  }
+  void rewind() { p = text; }
+};
+
+static void fill(int32_t v[ACQ_SENSORS], int32_t t, int32_t ph, int32_t sal) {
+  v[ACQ_TEMP] = t; v[ACQ_PH] = ph; v[ACQ_SAL] = sal;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_median5_matches_sorted_middle() {
+  const int32_t perms[][5] = {
+    {1,2,3,4,5}, {5,4,3,2,1}, {3,1,5,2,4}, {2,5,1,4,3}, {9,9,1,9,1}, {-7,0,7,-3,3},
+  };
+  const int32_t expect[] = { 3, 3, 3, 3, 9, 0 };
+  for (size_t i=0;i<sizeof(expect)/sizeof(expect[0]);++i) {
+    const int32_t* a = perms[i];
+    TEST_ASSERT_EQUAL_INT32(expect[i], acqMedian5(a[0],a[1],a[2],a[3],a[4]));
+  }
+}
+
+static void test_single_spike_is_rejected() {
+  AcqFilter f; f.reset();
+  int32_t in[ACQ_SENSORS], out[ACQ_SENSORS];
+  bool got = false;
+  for (int i=0;i<ACQ_DECIM;++i) {
+    fill(in, 26000, 8100, 35000);
+    if (i == 12) fill(in, 90000, 14000, 0);   // one-sample glitch on every probe
+    got = f.push(in, out);
+  }
+  TEST_ASSERT_TRUE(got);
+  TEST_ASSERT_EQUAL_INT32(26000, out[ACQ_TEMP]);
+  TEST_ASSERT_EQUAL_INT32(8100,  out[ACQ_PH]);
+  TEST_ASSERT_EQUAL_INT32(35000, out[ACQ_SAL]);
+}
+
+static void test_iir_converges_on_step() {
+  AcqFilter f; f.reset();
+  int32_t in[ACQ_SENSORS], out[ACQ_SENSORS];
+  fill(in, 25000, 8000, 34000);
+  for (int i=0;i<ACQ_DECIM;++i) f.push(in, out);
+  fill(in, 26000, 8200, 35000);
+  int32_t prev = 25000;
+  for (int k=0;k<4;++k) {
+    for (int i=0;i<ACQ_DECIM;++i) f.push(in, out);
+    TEST_ASSERT_TRUE(out[ACQ_TEMP] >= prev);    // monotonic, no overshoot
+    TEST_ASSERT_TRUE(out[ACQ_TEMP] <= 26000);
+    prev = out[ACQ_TEMP];
+  }
+  TEST_ASSERT_INT32_WITHIN(2, 26000, out[ACQ_TEMP]);
+  TEST_ASSERT_INT32_WITHIN(2, 8200,  out[ACQ_PH]);
+  TEST_ASSERT_INT32_WITHIN(2, 35000, out[ACQ_SAL]);
+}
+
+static void test_decimates_one_in_25() {
+  AcqFilter f; f.reset();
+  int32_t in[ACQ_SENSORS], out[ACQ_SENSORS];
+  fill(in, 1, 2, 3);
+  int outputs = 0;
+  for (int i=1;i<=ACQ_DECIM*4;++i) {
+    const bool got = f.push(in, out);
+    TEST_ASSERT_EQUAL(i % ACQ_DECIM == 0, got);
+    outputs += got;
+  }
+  TEST_ASSERT_EQUAL(4, outputs);
+}
+
+static void test_parse_csv_rows() {
+  int32_t v[ACQ_SENSORS]; bool hasTs; double ts;
+  TEST_ASSERT_FALSE(acqParseCsvRow("ts,temperature,ph,salinity", v, hasTs, ts));
+  TEST_ASSERT_FALSE(acqParseCsvRow("# comment", v, hasTs, ts));
+  TEST_ASSERT_FALSE(acqParseCsvRow("26.1,8.1", v, hasTs, ts));
+  TEST_ASSERT_TRUE(acqParseCsvRow("26.512, 8.103, 35.2", v, hasTs, ts));
+  TEST_ASSERT_FALSE(hasTs);
+  TEST_ASSERT_EQUAL_INT32(26512, v[ACQ_TEMP]);
+  TEST_ASSERT_EQUAL_INT32(8103,  v[ACQ_PH]);
+  TEST_ASSERT_EQUAL_INT32(35200, v[ACQ_SAL]);
+  TEST_ASSERT_TRUE(acqParseCsvRow("1500,26.0,8.0,35.0\r", v, hasTs, ts));
+  TEST_ASSERT_TRUE(hasTs);
+  TEST_ASSERT_EQUAL_INT32(1500, (int32_t)ts);
+  TEST_ASSERT_EQUAL_INT32(26000, v[ACQ_TEMP]);
+}
+
+// Recorded-style trace with a header, a comment and a glitch row
+static const char* TRACE =
+  "temperature,ph,salinity\n"
+  "# probe bench, 50 Hz\n"
+  "26.00,8.10,35.0\n"
+  "26.00,8.10,35.0\n"
+  "26.00,8.10,35.0\n"
+  "26.00,8.10,35.0\n"
+  "85.00,0.00,0.0\n"
+  "26.00,8.10,35.0\n"
+  "26.00,8.10,35.0\n"
+  "26.00,8.10,35.0\n";
+
+static void test_replayed_trace_through_pipeline() {
+  StrReader r(TRACE);
+  AcqCsvReplay<StrReader> replay(r);
+  AcqFilter f; f.reset();
+  int32_t in[ACQ_SENSORS], out[ACQ_SENSORS];
+  int outputs = 0;
+  for (uint32_t t=0; t<ACQ_DECIM*20*4; t+=20) {
+    TEST_ASSERT_TRUE(replay.sample(t, in));
+    if (f.push(in, out)) {
+      ++outputs;
+      TEST_ASSERT_EQUAL_INT32(26000, out[ACQ_TEMP]);
+      TEST_ASSERT_EQUAL_INT32(8100,  out[ACQ_PH]);
+      TEST_ASSERT_EQUAL_INT32(35000, out[ACQ_SAL]);
+    }
+  }
+  TEST_ASSERT_EQUAL(4, outputs);
+}
+
+// 10 Hz trace with ts in ms: each row must be held for 5 sample ticks
+static const char* TRACE_10HZ =
+  "ts,temperature,ph,salinity\n"
+  "1000,25.0,8.0,34.0\n"
+  "1100,25.1,8.0,34.0\n"
+  "1200,25.2,8.0,34.0\n";
+
+static void test_timed_trace_is_paced_by_ts() {
+  StrReader r(TRACE_10HZ);
+  AcqCsvReplay<StrReader> replay(r);
+  int32_t in[ACQ_SENSORS];
+  const uint32_t t0 = 7000;
+  for (uint32_t k=0; k<15; ++k) {
+    TEST_ASSERT_TRUE(replay.sample(t0 + k*20, in));
+    TEST_ASSERT_EQUAL_INT32(25000 + (int32_t)(k/5)*100, in[ACQ_TEMP]);
+  }
+  // last row played, the trace loops back to its first row
+  TEST_ASSERT_TRUE(replay.sample(t0 + 15*20, in));
+  TEST_ASSERT_EQUAL_INT32(25000, in[ACQ_TEMP]);
+  TEST_ASSERT_TRUE(replay.sample(t0 + 20*20, in));
+  TEST_ASSERT_EQUAL_INT32(25100, in[ACQ_TEMP]);
+}
+
+static void test_untimed_trace_plays_one_row_per_tick() {
+  StrReader r("25.0,8,34\n25.1,8,34\n25.2,8,34\n");
+  AcqCsvReplay<StrReader> replay(r);
+  int32_t in[ACQ_SENSORS];
+  const int32_t expect[] = { 25000, 25100, 25200, 25000, 25100 };
+  for (uint32_t k=0; k<5; ++k) {
+    TEST_ASSERT_TRUE(replay.sample(k*20, in));
+    TEST_ASSERT_EQUAL_INT32(expect[k], in[ACQ_TEMP]);
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_median5_matches_sorted_middle);
+  RUN_TEST(test_single_spike_is_rejected);
+  RUN_TEST(test_iir_converges_on_step);
+  RUN_TEST(test_decimates_one_in_25);
+  RUN_TEST(test_parse_csv_rows);
+  RUN_TEST(test_replayed_trace_through_pipeline);
+  RUN_TEST(test_timed_trace_is_paced_by_ts);
+  RUN_TEST(test_untimed_trace_plays_one_row_per_tick);
+  return UNITY_END();
+}